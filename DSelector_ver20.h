@@ -11,33 +11,17 @@
 #include "TH1I.h"
 #include "TH2I.h"
 
-// change thrownID and string_ph in place 
-Int_t getParents( Int_t* thrownID, vector<Int_t> parentIDs, vector<Int_t> thrownPIDs, TString* string_ph ){
-	Int_t initialThrownID = *thrownID;
-	*thrownID  = parentIDs[*thrownID];
-	Int_t thrownPID = thrownPIDs[*thrownID];
-	if (*thrownID != -1){
-		Int_t parentPID = thrownPIDs[*thrownID];
-		//cout << "ThrownID: " << initialThrownID << " with PID=" << thrownPID << " has *thrownID: " << *thrownID << " with PID=" << parentPID << endl;
-		*string_ph += "("+to_string(parentPID)+")";
-		return *thrownID;
-	}
-	else {
-		//cout << "Found primary particle" << endl;
-		//*string_ph += "(-1)";
-		return *thrownID;
-	}
-}
-
-struct topology {
-	TString locThrownTopology;
-	TString composition;
-	TString beamProtonID;
-	TString spectroscopicID;
-	double chiSq;
-	double unusedEnergy;
-	Int_t nUnusedShowers;
-};
+#include "TObjString.h"
+#include "TProofServ.h"
+
+#include "thrownAncestry.h"
+#include "compositionOutput.h"
+#include "compositionSummary.h"
+#include "uniquenessTracker.h"
+#include "measuredPhotonCache.h"
+#include "comboCuts.h"
+#include "branchReading.h"
+#include "stageTimers.h"
 
 class DSelector_ver20 : public DSelector
 {
@@ -52,6 +36,8 @@ class DSelector_ver20 : public DSelector
 	private:
 
 		void Get_ComboWrappers(void);
+		void Parse_Options(void);
+		void Setup_BranchReading(TTree* locTree);
 		void Finalize(void);
 
 		// BEAM POLARIZATION INFORMATION
@@ -61,7 +47,7 @@ class DSelector_ver20 : public DSelector
 
 		// ANALYZE CUT ACTIONS
 		// // Automatically makes mass histograms where one cut is missing
-		DHistogramAction_AnalyzeCutActions* dAnalyzeCutActions;
+		DHistogramAction_AnalyzeCutActions* dAnalyzeCutActions = NULL;
 
 		//CREATE REACTION-SPECIFIC PARTICLE ARRAYS
 
@@ -103,7 +89,51 @@ class DSelector_ver20 : public DSelector
 		TH2F* dHist_eventVsChiSq1234;
 		TH2F* dHist_ChiSq1234VsChiSqCombo;
 
-		ofstream compositionFile;
+		// UNIQUENESS TRACKING: kept across events so the tables are not reallocated, Reset() at the start of each event
+		UniquenessTracker<1> dUsedSoFar_BeamEnergy;
+		UniquenessTracker<1, 1, 4> dUsedSoFar_MissingMass;
+		UniquenessTracker<2, 2> dUsedSoFar_pi0_eta;
+		UniquenessTracker<4> dUsedSoFar_ph1234;
+
+		// measured photons of the current event, rebuilt once per event
+		MeasuredPhotonCache dMeasuredPhotonCache;
+
+		// thrown decay chains of the current event, rebuilt once per event
+		ThrownAncestry dThrownAncestry;
+
+		// COMPOSITION OUTPUT: one file per worker, <dCompositionOutputDir>/<dCompositionTag>_<worker ordinal>.root (.txt)
+		// options (space separated, passed through the runner): compositionDir=<dir> compositionTag=<tag> compositionText cutConfig=<file>
+		CompositionWriter dCompositionWriter;
+		TString dCompositionOutputDir = "/d/grid13/ln16/topologyAnalysis/logFile/data/";
+		TString dCompositionTag = "composition";
+		bool dCompositionTextFlag = false; //the old text dump, for debugging
+
+		// COMBO CUTS: evaluated once per combo into topology::cutMask; cutConfig=<file> replaces the default cuts
+		ComboCutSet dCutSet;
+		TString dCutConfigFileName;
+		bool dSetupFailedFlag = false; //cutConfig did not load or the composition output cannot be created: the job is aborted
+		vector<topology> dComboRecords; //combos of the current event, reused between events
+
+		// INPUT READING: minimalBranches restricts GetEntry and the TTreeCache to dBranchReadList (implies readStats),
+		// readStats reports bytes read and decompression time (readStatistics histogram and printout),
+		// skipActions leaves out the generic analysis actions (and the branches only they read)
+		bool dMinimalBranchesFlag = false;
+		bool dSkipActionsFlag = false;
+		bool dReadStatisticsFlag = false;
+		TString dExtraReadBranches; //readBranches=<pattern>,<pattern>,...
+		Long64_t dTreeCacheSize = 30000000;
+		BranchReadList dBranchReadList;
+		ReadStatistics dReadStatistics;
+
+		// INSTRUMENTATION: stageTimers switches on the per-stage timers and counters (stageTime, stageCalls, stageCounters
+		// and ancestryDepth histograms), verbose=<N> the printout: 1 the per-worker summaries, 2 also per combo
+		StageTimers dStageTimers;
+		bool dStageTimersFlag = false;
+		Int_t dVerbosity = 0;
+
+		// COMPOSITION SUMMARY: notebook tables as mergeable histograms in dOutputFileName
+		CompositionSummary dCompositionSummary;
+		TTree* dInputTree;
 
 	ClassDef(DSelector_ver20, 0);
 };
@@ -126,4 +156,34 @@ void DSelector_ver20::Get_ComboWrappers(void)
 	dPhoton4Wrapper = static_cast<DNeutralParticleHypothesis*>(dStep2Wrapper->Get_FinalParticle(1));
 }
 
+void DSelector_ver20::Parse_Options(void)
+{
+	TObjArray* locTokens = TString(GetOption()).Tokenize(" ");
+	for(Int_t loc_i = 0; loc_i < locTokens->GetEntries(); ++loc_i)
+	{
+		TString locToken = static_cast<TObjString*>(locTokens->At(loc_i))->GetString();
+		if(locToken.BeginsWith("compositionDir="))
+			dCompositionOutputDir = locToken(15, locToken.Length()) + "/";
+		else if(locToken.BeginsWith("compositionTag="))
+			dCompositionTag = locToken(15, locToken.Length());
+		else if(locToken == "compositionText")
+			dCompositionTextFlag = true;
+		else if(locToken.BeginsWith("cutConfig="))
+			dCutConfigFileName = locToken(10, locToken.Length());
+		else if(locToken == "minimalBranches")
+			dMinimalBranchesFlag = dReadStatisticsFlag = true;
+		else if(locToken == "skipActions")
+			dSkipActionsFlag = true;
+		else if(locToken == "readStats")
+			dReadStatisticsFlag = true;
+		else if(locToken.BeginsWith("readBranches="))
+			dExtraReadBranches = locToken(13, locToken.Length());
+		else if(locToken == "stageTimers")
+			dStageTimersFlag = true;
+		else if(locToken.BeginsWith("verbose="))
+			dVerbosity = TString(locToken(8, locToken.Length())).Atoi();
+	}
+	delete locTokens;
+}
+
 #endif // DSelector_ver20_h
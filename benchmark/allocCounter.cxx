@@ -0,0 +1,68 @@
+// operator new counting shim for benchmarkSelector.C, preloaded in front of ROOT
+// Only C++ allocations are counted (ROOT and the selector), not direct malloc calls.
+//
+// g++ -O2 -std=c++11 -shared -fPIC -o libAllocCounter.so allocCounter.cxx
+// LD_PRELOAD=./libAllocCounter.so root -l -b -q 'benchmarkSelector.C("synthetic_pi0eta.root")'
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long long> gNumAllocations(0);
+
+// looked up by benchmarkSelector.C with dlsym, so the macro also runs without the shim
+extern "C" unsigned long long allocCounter_GetNumAllocations(void)
+{
+	return gNumAllocations.load(std::memory_order_relaxed);
+}
+
+static void* countedAllocate(std::size_t locSize)
+{
+	gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* locPointer = std::malloc((locSize > 0) ? locSize : 1);
+	if(locPointer == NULL)
+		throw std::bad_alloc();
+	return locPointer;
+}
+
+void* operator new(std::size_t locSize)
+{
+	return countedAllocate(locSize);
+}
+
+void* operator new[](std::size_t locSize)
+{
+	return countedAllocate(locSize);
+}
+
+void* operator new(std::size_t locSize, const std::nothrow_t&) noexcept
+{
+	gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc((locSize > 0) ? locSize : 1);
+}
+
+void* operator new[](std::size_t locSize, const std::nothrow_t&) noexcept
+{
+	gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc((locSize > 0) ? locSize : 1);
+}
+
+void operator delete(void* locPointer) noexcept
+{
+	std::free(locPointer);
+}
+
+void operator delete[](void* locPointer) noexcept
+{
+	std::free(locPointer);
+}
+
+void operator delete(void* locPointer, const std::nothrow_t&) noexcept
+{
+	std::free(locPointer);
+}
+
+void operator delete[](void* locPointer, const std::nothrow_t&) noexcept
+{
+	std::free(locPointer);
+}
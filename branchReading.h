@@ -0,0 +1,177 @@
+#ifndef branchReading_h
+#define branchReading_h
+
+#include <iostream>
+#include <vector>
+
+#include "Rtypes.h"
+#include "TString.h"
+#include "TRegexp.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TFile.h"
+#include "TTreePerfStats.h"
+#include "TStopwatch.h"
+#include "TH1D.h"
+#include "TROOT.h"
+
+using namespace std;
+
+// Branches of the input tree the selector actually reads, declared as wildcard patterns.
+//
+// The DSelector wrappers bind every branch at Init(), so which branches are used cannot be observed by running a
+// few entries: the list is declared next to the code that reads it instead. Expand() matches the patterns against
+// the branches of each new tree; only the matches are then registered with the tree interface (GetEntry skips the
+// rest) and added to the TTreeCache, whose learning phase is stopped since the branch set is already known.
+class BranchReadList
+{
+	public:
+
+		void Add_Pattern(const TString& locPattern){dPatterns.push_back(locPattern);}
+		// comma-separated
+		void Add_Patterns(const TString& locPatterns);
+		size_t Get_NumPatterns(void) const{return dPatterns.size();}
+
+		// names of the matched top-level branches of locTree, also added to its TTreeCache. locPrintFlag: report the
+		// patterns that match no branch
+		const vector<TString>& Expand(TTree* locTree, Long64_t locCacheSize, bool locPrintFlag);
+
+	private:
+		vector<TString> dPatterns;
+		vector<TString> dBranchNames;
+};
+
+inline void BranchReadList::Add_Patterns(const TString& locPatterns)
+{
+	Ssiz_t locFrom = 0;
+	TString locPattern;
+	while(locPatterns.Tokenize(locPattern, locFrom, ","))
+		Add_Pattern(locPattern);
+}
+
+inline const vector<TString>& BranchReadList::Expand(TTree* locTree, Long64_t locCacheSize, bool locPrintFlag)
+{
+	dBranchNames.clear();
+	TObjArray* locBranches = (locTree != NULL) ? locTree->GetListOfBranches() : NULL;
+	if(locBranches == NULL)
+		return dBranchNames;
+
+	vector<bool> locMatchedFlags(dPatterns.size(), false);
+	for(Int_t loc_i = 0; loc_i < locBranches->GetEntries(); ++loc_i)
+	{
+		TString locBranchName = static_cast<TBranch*>(locBranches->At(loc_i))->GetName();
+		for(size_t loc_j = 0; loc_j < dPatterns.size(); ++loc_j)
+		{
+			TRegexp locRegexp(dPatterns[loc_j], kTRUE);
+			Ssiz_t locLength = 0;
+			if((locRegexp.Index(locBranchName, &locLength) != 0) || (locLength != locBranchName.Length()))
+				continue;
+			locMatchedFlags[loc_j] = true;
+			dBranchNames.push_back(locBranchName);
+			break;
+		}
+	}
+	for(size_t loc_j = 0; loc_j < dPatterns.size(); ++loc_j)
+	{
+		if(locPrintFlag && !locMatchedFlags[loc_j])
+			cout << "BranchReadList: no branch of " << locTree->GetName() << " matches " << dPatterns[loc_j] << endl;
+	}
+
+	locTree->SetCacheSize(locCacheSize);
+	for(const TString& locBranchName : dBranchNames)
+		locTree->AddBranchToCache(locBranchName, kTRUE);
+	locTree->StopCacheLearningPhase();
+	return dBranchNames;
+}
+
+// Input I/O cost of a worker: bytes and read calls from the TFile counters, basket decompression and disk time
+// from a TTreePerfStats attached to each input tree. Filled into a fixed-bin histogram, so the PROOF merge sums it.
+class ReadStatistics
+{
+	public:
+
+		enum StatisticBin {kNumFiles = 1, kNumEntries, kMegaBytesRead, kNumReadCalls, kUnzipTime, kDiskTime, kRealTime, kCpuTime, kNumStatisticBins = kCpuTime};
+
+		// creates the histogram in the current directory (the DSelector output file)
+		void Initialize(void);
+		// call from every Init(): closes out the previous tree
+		void Begin_Tree(TTree* locTree);
+		void Count_Entry(void){++dNumEntries;}
+		// fills the histogram, and prints the totals of this worker if locPrintFlag
+		void Finalize(bool locPrintFlag);
+
+	private:
+
+		void End_Tree(void);
+
+		TH1D* dHist_readStatistics = NULL;
+		TTreePerfStats* dPerfStats = NULL;
+		TTree* dPerfStatsTree = NULL; //the tree dPerfStats is attached to
+		TFile* dPerfStatsFile = NULL;
+		TStopwatch dStopwatch;
+
+		Long64_t dStartBytesRead = 0;
+		Int_t dStartReadCalls = 0;
+		Long64_t dNumFiles = 0, dNumEntries = 0, dBytesRead = 0, dReadCalls = 0;
+		double dUnzipTime = 0.0, dDiskTime = 0.0;
+};
+
+inline void ReadStatistics::Initialize(void)
+{
+	const char* locLabels[kNumStatisticBins] = {"files", "entries", "MB read", "read calls", "unzip time (s)", "disk time (s)", "real time (s)", "cpu time (s)"};
+	dHist_readStatistics = new TH1D("readStatistics", ";;Sum over workers", kNumStatisticBins, 0.5, kNumStatisticBins + 0.5);
+	for(Int_t loc_i = 0; loc_i < kNumStatisticBins; ++loc_i)
+		dHist_readStatistics->GetXaxis()->SetBinLabel(loc_i + 1, locLabels[loc_i]);
+}
+
+inline void ReadStatistics::Begin_Tree(TTree* locTree)
+{
+	End_Tree();
+	if(dNumFiles == 0)
+		dStopwatch.Start();
+	++dNumFiles;
+	dStartBytesRead = TFile::GetFileBytesRead();
+	dStartReadCalls = TFile::GetFileReadCalls();
+	dPerfStats = new TTreePerfStats("readStatistics_perfStats", locTree);
+	dPerfStatsTree = locTree;
+	dPerfStatsFile = locTree->GetCurrentFile();
+}
+
+inline void ReadStatistics::End_Tree(void)
+{
+	if(dPerfStats == NULL)
+		return;
+	dBytesRead += TFile::GetFileBytesRead() - dStartBytesRead;
+	dReadCalls += TFile::GetFileReadCalls() - dStartReadCalls;
+	dUnzipTime += dPerfStats->GetUnzipTime();
+	dDiskTime += dPerfStats->GetDiskTime();
+	// detach before deleting: the tree can outlive the job (e.g. benchmarkSelector.C processes it again). If its
+	// file was closed in the meantime (PROOF moving to the next file), the tree is gone as well
+	bool locTreeAliveFlag = (dPerfStatsFile == NULL) || (gROOT->GetListOfFiles()->FindObject(dPerfStatsFile) != NULL);
+	if(locTreeAliveFlag && (dPerfStatsTree->GetPerfStats() == dPerfStats))
+		dPerfStatsTree->SetPerfStats(NULL);
+	delete dPerfStats;
+	dPerfStats = NULL;
+	dPerfStatsTree = NULL;
+	dPerfStatsFile = NULL;
+}
+
+inline void ReadStatistics::Finalize(bool locPrintFlag)
+{
+	End_Tree();
+	dStopwatch.Stop();
+	double locValues[kNumStatisticBins] = {double(dNumFiles), double(dNumEntries), dBytesRead/1.0E6, double(dReadCalls), dUnzipTime, dDiskTime,
+		dStopwatch.RealTime(), dStopwatch.CpuTime()};
+	for(Int_t loc_i = 0; loc_i < kNumStatisticBins; ++loc_i)
+	{
+		if(dHist_readStatistics != NULL)
+			dHist_readStatistics->SetBinContent(loc_i + 1, locValues[loc_i]);
+	}
+
+	if(!locPrintFlag)
+		return;
+	cout << "ReadStatistics: " << dNumEntries << " entries from " << dNumFiles << " files, " << dBytesRead/1.0E6 << " MB in " << dReadCalls
+		<< " read calls, unzip " << dUnzipTime << " s, disk " << dDiskTime << " s, real " << dStopwatch.RealTime() << " s" << endl;
+}
+
+#endif // branchReading_h
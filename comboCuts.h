@@ -0,0 +1,198 @@
+#ifndef comboCuts_h
+#define comboCuts_h
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <limits>
+
+#include "Rtypes.h"
+#include "TString.h"
+
+using namespace std;
+
+// Cuts on the combos of the composition study, declared once and evaluated in one pass into a bitmask per combo.
+//
+// A cut is a window min < value < max on one variable and owns one bit of the mask. A variant is a named
+// combination of cuts (a required mask): a combo passes the variant if all of its bits are set. Variants are
+// what the per-event weights and composition histograms are made for, so scanning many cut combinations only
+// means declaring more variants, not rerunning.
+//
+// Config file format (one declaration per line, # starts a comment, inf/-inf allowed):
+//	cut <name> <chiSq|unusedEnergy|showerQuality|pi0Mass|etaMass> <min> <max>
+//	variant <name> <cut1>*<cut2>*...		(or "none" for no cut)
+// pi0Mass and etaMass are the measured two-photon masses (the kinematic fit constrains both to the nominal mass)
+class ComboCutSet
+{
+	public:
+
+		enum CutVariable {kChiSq = 0, kUnusedEnergy, kShowerQuality, kPi0Mass, kEtaMass, kNumCutVariables};
+		static const size_t kMaxNumCuts = 32;
+
+		// returns the bit of the new cut, -1 on failure
+		Int_t Add_Cut(const TString& locName, CutVariable locVariable, double locMin, double locMax);
+		// locCuts: cut names joined by '*', "none" or "" for no cut. false on unknown cut name
+		bool Add_Variant(const TString& locName, const TString& locCuts);
+		bool Read_Config(const TString& locFileName);
+		void Clear(void);
+
+		UInt_t Evaluate(const double locValues[kNumCutVariables]) const;
+		bool Pass(UInt_t locCutMask, size_t locVariant) const{return (locCutMask & dVariantMasks[locVariant]) == dVariantMasks[locVariant];}
+
+		// e.g. only read the shower quality if a cut needs it (the branch is not in every tree)
+		bool Get_UsesVariable(CutVariable locVariable) const{return dUsedVariables & (1 << locVariable);}
+
+		size_t Get_NumCuts(void) const{return dCutNames.size();}
+		size_t Get_NumVariants(void) const{return dVariantNames.size();}
+		const TString& Get_CutName(size_t locCut) const{return dCutNames[locCut];}
+		const TString& Get_VariantName(size_t locVariant) const{return dVariantNames[locVariant];}
+		TString Get_CutDescription(size_t locCut) const;
+
+		static const char* Get_VariableName(Int_t locVariable)
+		{
+			static const char* locNames[kNumCutVariables] = {"chiSq", "unusedEnergy", "showerQuality", "pi0Mass", "etaMass"};
+			return locNames[locVariable];
+		}
+
+	private:
+
+		vector<TString> dCutNames;
+		vector<Int_t> dCutVariables;
+		vector<double> dCutMins, dCutMaxes;
+		UInt_t dUsedVariables = 0;
+
+		vector<TString> dVariantNames;
+		vector<UInt_t> dVariantMasks;
+};
+
+inline void ComboCutSet::Clear(void)
+{
+	dCutNames.clear();
+	dCutVariables.clear();
+	dCutMins.clear();
+	dCutMaxes.clear();
+	dUsedVariables = 0;
+	dVariantNames.clear();
+	dVariantMasks.clear();
+}
+
+inline Int_t ComboCutSet::Add_Cut(const TString& locName, CutVariable locVariable, double locMin, double locMax)
+{
+	if(dCutNames.size() >= kMaxNumCuts)
+	{
+		cout << "ComboCutSet: too many cuts, ignoring " << locName << endl;
+		return -1;
+	}
+	dCutNames.push_back(locName);
+	dCutVariables.push_back(locVariable);
+	dCutMins.push_back(locMin);
+	dCutMaxes.push_back(locMax);
+	dUsedVariables |= (1 << locVariable);
+	return dCutNames.size() - 1;
+}
+
+inline bool ComboCutSet::Add_Variant(const TString& locName, const TString& locCuts)
+{
+	UInt_t locMask = 0;
+	TString locCutList = locCuts;
+	if(locCutList == "none")
+		locCutList = "";
+	Ssiz_t locFrom = 0;
+	TString locCutName;
+	while(locCutList.Tokenize(locCutName, locFrom, "*"))
+	{
+		size_t locCut = 0;
+		for(; locCut < dCutNames.size(); ++locCut)
+		{
+			if(dCutNames[locCut] == locCutName)
+				break;
+		}
+		if(locCut == dCutNames.size())
+		{
+			cout << "ComboCutSet: variant " << locName << " uses unknown cut " << locCutName << endl;
+			return false;
+		}
+		locMask |= (1u << locCut);
+	}
+	dVariantNames.push_back(locName);
+	dVariantMasks.push_back(locMask);
+	return true;
+}
+
+inline bool ComboCutSet::Read_Config(const TString& locFileName)
+{
+	ifstream locConfigFile(locFileName.Data());
+	if(!locConfigFile)
+	{
+		cout << "ComboCutSet: cannot open " << locFileName << endl;
+		return false;
+	}
+
+	string locLine;
+	while(getline(locConfigFile, locLine))
+	{
+		locLine = locLine.substr(0, locLine.find('#'));
+		istringstream locLineStream(locLine);
+		string locKeyword, locName;
+		if(!(locLineStream >> locKeyword >> locName))
+			continue;
+
+		if(locKeyword == "cut")
+		{
+			string locVariableName, locMinString, locMaxString;
+			locLineStream >> locVariableName >> locMinString >> locMaxString;
+			Int_t locVariable = 0;
+			for(; locVariable < kNumCutVariables; ++locVariable)
+			{
+				if(locVariableName == Get_VariableName(locVariable))
+					break;
+			}
+			if((locVariable == kNumCutVariables) || locMaxString.empty())
+			{
+				cout << "ComboCutSet: cannot parse \"" << locLine << "\"" << endl;
+				return false;
+			}
+			if(Add_Cut(locName, CutVariable(locVariable), strtod(locMinString.c_str(), NULL), strtod(locMaxString.c_str(), NULL)) < 0)
+				return false;
+		}
+		else if(locKeyword == "variant")
+		{
+			string locCuts = "none";
+			locLineStream >> locCuts;
+			if(!Add_Variant(locName, locCuts))
+				return false;
+		}
+		else
+		{
+			cout << "ComboCutSet: unknown keyword in \"" << locLine << "\"" << endl;
+			return false;
+		}
+	}
+	if(dVariantNames.empty())
+	{
+		cout << "ComboCutSet: " << locFileName << " defines no variants" << endl;
+		return false;
+	}
+	return true;
+}
+
+inline UInt_t ComboCutSet::Evaluate(const double locValues[kNumCutVariables]) const
+{
+	UInt_t locMask = 0;
+	for(size_t locCut = 0; locCut < dCutNames.size(); ++locCut)
+	{
+		double locValue = locValues[dCutVariables[locCut]];
+		locMask |= UInt_t((locValue > dCutMins[locCut]) && (locValue < dCutMaxes[locCut])) << locCut;
+	}
+	return locMask;
+}
+
+inline TString ComboCutSet::Get_CutDescription(size_t locCut) const
+{
+	return dCutNames[locCut] + ": " + TString::Format("%g < %s < %g", dCutMins[locCut], Get_VariableName(dCutVariables[locCut]), dCutMaxes[locCut]);
+}
+
+#endif // comboCuts_h
@@ -0,0 +1,214 @@
+#ifndef compositionOutput_h
+#define compositionOutput_h
+
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "Rtypes.h"
+#include "TString.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TDirectory.h"
+
+#include "thrownAncestry.h"
+#include "comboCuts.h"
+
+using namespace std;
+
+// one combo entering the composition study. composition and topology are codes into the ThrownAncestry dictionaries
+struct topology {
+	Int_t topologyCode;
+	Int_t compositionCode;
+	Int_t beamID;
+	Int_t protonID;
+	Int_t neutralIDs[4];
+	double chiSq;
+	double unusedEnergy;
+	Int_t nUnusedShowers;
+	UInt_t cutMask; //bit i: passed cut i of the ComboCutSet
+};
+
+// Writes the combos of the composition study for one worker.
+//
+// Default is a columnar TTree "composition" (one entry per combo, buffered by ROOT) in <baseName>.root. The
+// topology, composition and input file name columns are dictionary encoded: the code -> string tables (and the
+// meaning of the cutMask bits) are written to the TTree "compositionDictionary" when the file is closed. Codes are only valid within one file,
+// so per-worker files are combined with mergeComposition.C, which remaps them.
+//
+// The old space separated text dump (<baseName>.txt) can still be switched on for debugging.
+class CompositionWriter
+{
+	public:
+
+		enum DictionaryType {kTopologyDictionary = 0, kCompositionDictionary = 1, kSourceFileDictionary = 2, kCutDictionary = 3, kNumDictionaryTypes = 4};
+
+		// false (after printing the path) if an output file cannot be created
+		bool Open(const TString& locBaseName, bool locTreeFlag, bool locTextFlag);
+		void Close(const ThrownAncestry& locThrownAncestry, const ComboCutSet& locCutSet);
+
+		// call once per event before Fill()
+		void Set_Event(const TString& locSourceFile, Long64_t locEntry, UInt_t locRunNumber, ULong64_t locEventNumber);
+		void Fill(const topology& locTopology, const ThrownAncestry& locThrownAncestry, double locEventNum);
+
+	private:
+
+		TFile* dFile = NULL;
+		TTree* dTree = NULL;
+		ofstream dTextFile;
+
+		// source file dictionary
+		map<TString, Int_t> dSourceFileCodes;
+		TString dSourceFile;
+
+		// branch buffers
+		Int_t dTopologyCode;
+		Int_t dCompositionCode;
+		Int_t dSourceFileCode = -1;
+		Long64_t dEntry;
+		UInt_t dRunNumber;
+		ULong64_t dEventNumber;
+		Int_t dBeamID;
+		Int_t dProtonID;
+		Int_t dNeutralIDs[4];
+		Float_t dChiSq;
+		Float_t dUnusedEnergy;
+		Int_t dNumUnusedShowers;
+		UInt_t dCutMask;
+};
+
+inline bool CompositionWriter::Open(const TString& locBaseName, bool locTreeFlag, bool locTextFlag)
+{
+	if(locTextFlag)
+	{
+		dTextFile.open((locBaseName + ".txt").Data(), std::ios_base::trunc);
+		if(!dTextFile.is_open())
+		{
+			cout << "CompositionWriter: cannot create " << locBaseName << ".txt" << endl;
+			return false;
+		}
+	}
+	if(!locTreeFlag)
+		return true;
+
+	TDirectory::TContext locContext; //don't move gDirectory away from the DSelector output file
+	dFile = new TFile(locBaseName + ".root", "RECREATE");
+	if(dFile->IsZombie()) //else the tree would end up in the current directory, the DSelector output file
+	{
+		cout << "CompositionWriter: cannot create " << locBaseName << ".root" << endl;
+		delete dFile;
+		dFile = NULL;
+		return false;
+	}
+	dFile->cd();
+	dTree = new TTree("composition", "combos of the pi0 eta composition study");
+	dTree->Branch("topology", &dTopologyCode, "topology/I");
+	dTree->Branch("composition", &dCompositionCode, "composition/I");
+	dTree->Branch("sourceFile", &dSourceFileCode, "sourceFile/I");
+	dTree->Branch("entry", &dEntry, "entry/L");
+	dTree->Branch("runNumber", &dRunNumber, "runNumber/i");
+	dTree->Branch("eventNumber", &dEventNumber, "eventNumber/l");
+	dTree->Branch("beamID", &dBeamID, "beamID/I");
+	dTree->Branch("protonID", &dProtonID, "protonID/I");
+	dTree->Branch("neutralIDs", dNeutralIDs, "neutralIDs[4]/I");
+	dTree->Branch("chiSq", &dChiSq, "chiSq/F");
+	dTree->Branch("unusedEnergy", &dUnusedEnergy, "unusedEnergy/F");
+	dTree->Branch("nUnusedShowers", &dNumUnusedShowers, "nUnusedShowers/I");
+	dTree->Branch("cutMask", &dCutMask, "cutMask/i");
+	return true;
+}
+
+inline void CompositionWriter::Set_Event(const TString& locSourceFile, Long64_t locEntry, UInt_t locRunNumber, ULong64_t locEventNumber)
+{
+	if((dSourceFileCode < 0) || (locSourceFile != dSourceFile))
+	{
+		auto locIterator = dSourceFileCodes.find(locSourceFile);
+		if(locIterator == dSourceFileCodes.end())
+			locIterator = dSourceFileCodes.insert(make_pair(locSourceFile, Int_t(dSourceFileCodes.size()))).first;
+		dSourceFileCode = locIterator->second;
+		dSourceFile = locSourceFile;
+	}
+	dEntry = locEntry;
+	dRunNumber = locRunNumber;
+	dEventNumber = locEventNumber;
+}
+
+inline void CompositionWriter::Fill(const topology& locTopology, const ThrownAncestry& locThrownAncestry, double locEventNum)
+{
+	if(dTree != NULL)
+	{
+		dTopologyCode = locTopology.topologyCode;
+		dCompositionCode = locTopology.compositionCode;
+		dBeamID = locTopology.beamID;
+		dProtonID = locTopology.protonID;
+		for(int loc_i = 0; loc_i < 4; ++loc_i)
+			dNeutralIDs[loc_i] = locTopology.neutralIDs[loc_i];
+		dChiSq = locTopology.chiSq;
+		dUnusedEnergy = locTopology.unusedEnergy;
+		dNumUnusedShowers = locTopology.nUnusedShowers;
+		dCutMask = locTopology.cutMask;
+		dTree->Fill();
+	}
+
+	if(dTextFile.is_open())
+	{
+		dTextFile << locThrownAncestry.Get_TopologyString(locTopology.topologyCode) << " "
+			<< locThrownAncestry.Get_CompositionString(locTopology.compositionCode) << " " << locEventNum << " "
+			<< locTopology.beamID << "_" << locTopology.protonID << " "
+			<< locTopology.neutralIDs[0] << "_" << locTopology.neutralIDs[1] << "_" << locTopology.neutralIDs[2] << "_" << locTopology.neutralIDs[3] << " "
+			<< locTopology.chiSq << " " << locTopology.unusedEnergy << " " << locTopology.nUnusedShowers << "\n";
+	}
+}
+
+inline void CompositionWriter::Close(const ThrownAncestry& locThrownAncestry, const ComboCutSet& locCutSet)
+{
+	if(dTextFile.is_open())
+		dTextFile.close();
+	if(dFile == NULL)
+		return;
+
+	TDirectory::TContext locContext(dFile);
+
+	//names are std::string: topology and composition strings have no length limit
+	Int_t locType, locCode;
+	string locName;
+	TTree* locDictionaryTree = new TTree("compositionDictionary", "code to string tables of the composition tree");
+	locDictionaryTree->Branch("type", &locType, "type/I");
+	locDictionaryTree->Branch("code", &locCode, "code/I");
+	locDictionaryTree->Branch("name", &locName);
+
+	locType = kTopologyDictionary;
+	for(locCode = 0; locCode < Int_t(locThrownAncestry.Get_NumTopologies()); ++locCode)
+	{
+		locName = locThrownAncestry.Get_TopologyString(locCode).Data();
+		locDictionaryTree->Fill();
+	}
+	locType = kCompositionDictionary;
+	for(locCode = 0; locCode < Int_t(locThrownAncestry.Get_NumCompositions()); ++locCode)
+	{
+		locName = locThrownAncestry.Get_CompositionString(locCode).Data();
+		locDictionaryTree->Fill();
+	}
+	locType = kSourceFileDictionary;
+	for(auto& locPair : dSourceFileCodes)
+	{
+		locCode = locPair.second;
+		locName = locPair.first.Data();
+		locDictionaryTree->Fill();
+	}
+	locType = kCutDictionary; //code: bit of cutMask
+	for(locCode = 0; locCode < Int_t(locCutSet.Get_NumCuts()); ++locCode)
+	{
+		locName = locCutSet.Get_CutDescription(locCode).Data();
+		locDictionaryTree->Fill();
+	}
+
+	dFile->Write();
+	dFile->Close();
+	delete dFile;
+	dFile = NULL;
+	dTree = NULL;
+}
+
+#endif // compositionOutput_h
@@ -0,0 +1,183 @@
+#ifndef compositionSummary_h
+#define compositionSummary_h
+
+#include <vector>
+#include <algorithm>
+
+#include "TString.h"
+#include "TH1D.h"
+#include "TH1I.h"
+#include "TH2D.h"
+
+#include "thrownAncestry.h"
+#include "compositionOutput.h"
+#include "comboCuts.h"
+
+using namespace std;
+
+// The reductions of composition.ipynb, accumulated per event into histograms that PROOF merges with the rest of
+// the DSelector output, so a full-statistics run gives the final tables without going through the per-combo dump.
+//
+// Compositions are histogrammed by their "unique" (photon-symmetric) label on alphanumeric axes, which merge
+// by label across workers. Per cut variant of the ComboCutSet every combo passing it (read from its cut mask) is
+// weighted by 1/(number of combos of the event passing it), so the sum of weights counts events. Purities are
+// ratios of bins of these histograms.
+class CompositionSummary
+{
+	public:
+
+		// creates the histograms in the current directory (the DSelector output file), one set per variant of locCutSet
+		void Initialize(const ComboCutSet& locCutSet);
+		void Fill_Event(const vector<topology>& locTopologies, const ThrownAncestry& locThrownAncestry);
+
+	private:
+
+		Int_t Get_UniqueCode(Int_t locCompositionCode, const ThrownAncestry& locThrownAncestry);
+		bool Get_IsSignalTopology(Int_t locTopologyCode, const ThrownAncestry& locThrownAncestry);
+
+		// notebook definitions
+		const TString dSignalTopology = "4#gammap[#pi^{0},#eta]";
+		const TString dTrueComposition = "(7)__(17)";
+
+		const ComboCutSet* dCutSet = NULL;
+
+		// composition code -> unique composition code, topology code -> signal flag (-1: not looked up yet)
+		vector<Int_t> dUniqueCodes;
+		vector<TString> dUniqueLabels;
+		vector<Int_t> dSignalTopologyFlags;
+		Int_t dTrueUniqueCode = -1;
+
+		// per-event scratch
+		vector<Int_t> dEventUniqueCodes;
+
+		vector<TH1D*> dHist_compositionWeighted;
+		vector<TH2D*> dHist_topologyVsComposition;
+		TH1D* dHist_signalEvents;
+		TH1D* dHist_signalEventsWithTrueCombo;
+		TH1I* dHist_numUniqueCompositionsPerEvent;
+		TH1D* dHist_singleCompositionEvents;
+		TH2D* dHist_compositionCoOccurrence;
+};
+
+inline void CompositionSummary::Initialize(const ComboCutSet& locCutSet)
+{
+	dCutSet = &locCutSet;
+	Int_t locNumVariants = locCutSet.Get_NumVariants();
+
+	dHist_signalEvents = new TH1D("signalEvents", ";Cut;Events with the signal topology", locNumVariants, 0, locNumVariants);
+	dHist_signalEventsWithTrueCombo = new TH1D("signalEventsWithTrueCombo", ";Cut;Events using the true combo at least once", locNumVariants, 0, locNumVariants);
+	dHist_compositionWeighted.resize(locNumVariants);
+	dHist_topologyVsComposition.resize(locNumVariants);
+	for(int loc_i = 0; loc_i < locNumVariants; ++loc_i)
+	{
+		TString locCutName = locCutSet.Get_VariantName(loc_i);
+		TString locCutTag = locCutName;
+		locCutTag.ReplaceAll("*", "");
+		dHist_compositionWeighted[loc_i] = new TH1D("compositionWeighted_" + locCutTag, locCutName + ";Composition of pion__eta;Events", 1, 0, 1);
+		dHist_compositionWeighted[loc_i]->SetCanExtend(TH1::kAllAxes);
+		dHist_topologyVsComposition[loc_i] = new TH2D("topologyVsComposition_" + locCutTag, locCutName + ";Thrown topology;Composition of pion__eta", 1, 0, 1, 1, 0, 1);
+		dHist_topologyVsComposition[loc_i]->SetCanExtend(TH1::kAllAxes);
+		dHist_signalEvents->GetXaxis()->SetBinLabel(loc_i + 1, locCutName);
+		dHist_signalEventsWithTrueCombo->GetXaxis()->SetBinLabel(loc_i + 1, locCutName);
+	}
+
+	// below: signal topology, no cut
+	dHist_numUniqueCompositionsPerEvent = new TH1I("numUniqueCompositionsPerEvent", ";Unique compositions per event", 20, 0, 20);
+	dHist_singleCompositionEvents = new TH1D("singleCompositionEvents", ";Composition of events with a single unique composition", 1, 0, 1);
+	dHist_singleCompositionEvents->SetCanExtend(TH1::kAllAxes);
+	// filled once per event with two unique compositions, lexicographically smaller label on x
+	dHist_compositionCoOccurrence = new TH2D("compositionCoOccurrence", ";Composition;Composition", 1, 0, 1, 1, 0, 1);
+	dHist_compositionCoOccurrence->SetCanExtend(TH1::kAllAxes);
+}
+
+inline Int_t CompositionSummary::Get_UniqueCode(Int_t locCompositionCode, const ThrownAncestry& locThrownAncestry)
+{
+	if(locCompositionCode >= Int_t(dUniqueCodes.size()))
+		dUniqueCodes.resize(locCompositionCode + 1, -1);
+	if(dUniqueCodes[locCompositionCode] != -1)
+		return dUniqueCodes[locCompositionCode];
+
+	// new composition: only now build its label
+	TString locLabel = locThrownAncestry.Get_UniqueCompositionString(locCompositionCode);
+	Int_t locUniqueCode = find(dUniqueLabels.begin(), dUniqueLabels.end(), locLabel) - dUniqueLabels.begin();
+	if(locUniqueCode == Int_t(dUniqueLabels.size()))
+	{
+		dUniqueLabels.push_back(locLabel);
+		if(locLabel == dTrueComposition)
+			dTrueUniqueCode = locUniqueCode;
+	}
+	dUniqueCodes[locCompositionCode] = locUniqueCode;
+	return locUniqueCode;
+}
+
+inline bool CompositionSummary::Get_IsSignalTopology(Int_t locTopologyCode, const ThrownAncestry& locThrownAncestry)
+{
+	if(locTopologyCode >= Int_t(dSignalTopologyFlags.size()))
+		dSignalTopologyFlags.resize(locTopologyCode + 1, -1);
+	if(dSignalTopologyFlags[locTopologyCode] == -1)
+		dSignalTopologyFlags[locTopologyCode] = (locThrownAncestry.Get_TopologyString(locTopologyCode) == dSignalTopology);
+	return dSignalTopologyFlags[locTopologyCode];
+}
+
+inline void CompositionSummary::Fill_Event(const vector<topology>& locTopologies, const ThrownAncestry& locThrownAncestry)
+{
+	if(locTopologies.empty())
+		return;
+
+	// all combos of an event share the thrown topology
+	Int_t locTopologyCode = locTopologies[0].topologyCode;
+	const TString& locTopologyLabel = locThrownAncestry.Get_TopologyString(locTopologyCode);
+	bool locIsSignalTopology = Get_IsSignalTopology(locTopologyCode, locThrownAncestry);
+
+	for(size_t locCutVariant = 0; locCutVariant < dCutSet->Get_NumVariants(); ++locCutVariant)
+	{
+		int locNumPassed = 0;
+		for(const auto& locTopology : locTopologies)
+			locNumPassed += dCutSet->Pass(locTopology.cutMask, locCutVariant);
+		if(locNumPassed == 0)
+			continue;
+
+		double locWeight = 1.0/locNumPassed;
+		bool locUsesTrueCombo = false;
+		for(const auto& locTopology : locTopologies)
+		{
+			if(!dCutSet->Pass(locTopology.cutMask, locCutVariant))
+				continue;
+			Int_t locUniqueCode = Get_UniqueCode(locTopology.compositionCode, locThrownAncestry);
+			locUsesTrueCombo |= (locUniqueCode == dTrueUniqueCode);
+			dHist_compositionWeighted[locCutVariant]->Fill(dUniqueLabels[locUniqueCode].Data(), locWeight);
+			dHist_topologyVsComposition[locCutVariant]->Fill(locTopologyLabel.Data(), dUniqueLabels[locUniqueCode].Data(), locWeight);
+		}
+
+		if(!locIsSignalTopology)
+			continue;
+		dHist_signalEvents->Fill(locCutVariant);
+		if(locUsesTrueCombo)
+			dHist_signalEventsWithTrueCombo->Fill(locCutVariant);
+	}
+
+	if(!locIsSignalTopology)
+		return;
+
+	// unique compositions of the event, no cut
+	dEventUniqueCodes.clear();
+	for(const auto& locTopology : locTopologies)
+		dEventUniqueCodes.push_back(Get_UniqueCode(locTopology.compositionCode, locThrownAncestry));
+	sort(dEventUniqueCodes.begin(), dEventUniqueCodes.end());
+	dEventUniqueCodes.erase(unique(dEventUniqueCodes.begin(), dEventUniqueCodes.end()), dEventUniqueCodes.end());
+
+	dHist_numUniqueCompositionsPerEvent->Fill(dEventUniqueCodes.size());
+	if(dEventUniqueCodes.size() == 1)
+		dHist_singleCompositionEvents->Fill(dUniqueLabels[dEventUniqueCodes[0]].Data(), 1.0);
+	else if(dEventUniqueCodes.size() == 2)
+	{
+		const TString& locLabel1 = dUniqueLabels[dEventUniqueCodes[0]];
+		const TString& locLabel2 = dUniqueLabels[dEventUniqueCodes[1]];
+		if(locLabel1 < locLabel2)
+			dHist_compositionCoOccurrence->Fill(locLabel1.Data(), locLabel2.Data(), 1.0);
+		else
+			dHist_compositionCoOccurrence->Fill(locLabel2.Data(), locLabel1.Data(), 1.0);
+	}
+}
+
+#endif // compositionSummary_h
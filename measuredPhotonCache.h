@@ -0,0 +1,80 @@
+#ifndef measuredPhotonCache_h
+#define measuredPhotonCache_h
+
+#include <vector>
+#include <cmath>
+
+#include "Rtypes.h"
+#include "TLorentzVector.h"
+
+using namespace std;
+
+// Per-event structure-of-arrays copy of the measured photon four-momenta, keyed by Get_NeutralID().
+//
+// Combos of an event are built from the same few showers: the measured photons are read from the neutral hypotheses
+// once per event, and the combo loop sums four slots instead of copying four measured TLorentzVectors per combo.
+// Only measured quantities can be cached this way: kinematic-fit four-momenta differ from combo to combo.
+class MeasuredPhotonCache
+{
+	public:
+
+		// call once per event, then Add_Photon() for every photon hypothesis
+		void Reset(void)
+		{
+			for(Int_t locNeutralID : dNeutralIDs)
+				dSlots[locNeutralID] = -1;
+			dNeutralIDs.clear();
+			dPx.clear();
+			dPy.clear();
+			dPz.clear();
+			dE.clear();
+		}
+		void Add_Photon(Int_t locNeutralID, const TLorentzVector& locP4);
+
+		// -1 if the shower is not in the cache
+		Int_t Get_Slot(Int_t locNeutralID) const
+		{
+			return ((locNeutralID >= 0) && (locNeutralID < Int_t(dSlots.size()))) ? dSlots[locNeutralID] : -1;
+		}
+
+		// arguments are slots. Same sign convention as TLorentzVector::M()
+		double Get_PairMass(Int_t locSlot1, Int_t locSlot2) const
+		{
+			double locE = dE[locSlot1] + dE[locSlot2], locPx = dPx[locSlot1] + dPx[locSlot2];
+			double locPy = dPy[locSlot1] + dPy[locSlot2], locPz = dPz[locSlot1] + dPz[locSlot2];
+			double locMass2 = locE*locE - locPx*locPx - locPy*locPy - locPz*locPz;
+			return (locMass2 < 0.0) ? -sqrt(-locMass2) : sqrt(locMass2);
+		}
+		TLorentzVector Get_P4Sum(Int_t locSlot1, Int_t locSlot2, Int_t locSlot3, Int_t locSlot4) const
+		{
+			return TLorentzVector(dPx[locSlot1] + dPx[locSlot2] + dPx[locSlot3] + dPx[locSlot4], dPy[locSlot1] + dPy[locSlot2] + dPy[locSlot3] + dPy[locSlot4],
+				dPz[locSlot1] + dPz[locSlot2] + dPz[locSlot3] + dPz[locSlot4], dE[locSlot1] + dE[locSlot2] + dE[locSlot3] + dE[locSlot4]);
+		}
+
+	private:
+
+		vector<Int_t> dSlots; //indexed by neutral ID, kept at -1 between events
+		vector<Int_t> dNeutralIDs;
+
+		// slot-indexed
+		vector<double> dPx, dPy, dPz, dE;
+};
+
+inline void MeasuredPhotonCache::Add_Photon(Int_t locNeutralID, const TLorentzVector& locP4)
+{
+	if(locNeutralID < 0)
+		return;
+	if(locNeutralID >= Int_t(dSlots.size()))
+		dSlots.resize(locNeutralID + 1, -1);
+	if(dSlots[locNeutralID] != -1)
+		return; //one photon hypothesis per shower
+
+	dSlots[locNeutralID] = dNeutralIDs.size();
+	dNeutralIDs.push_back(locNeutralID);
+	dPx.push_back(locP4.Px());
+	dPy.push_back(locP4.Py());
+	dPz.push_back(locP4.Pz());
+	dE.push_back(locP4.E());
+}
+
+#endif // measuredPhotonCache_h
@@ -0,0 +1,134 @@
+#ifndef stageTimers_h
+#define stageTimers_h
+
+#include <iostream>
+#include <chrono>
+
+#include "Rtypes.h"
+#include "TH1D.h"
+#include "TH1I.h"
+
+using namespace std;
+
+// Switchable instrumentation of DSelector_ver20::Process: wall time per stage and counters, accumulated per worker.
+//
+// Switched off (the default), Start()/Stop()/Count() are a flag test. Switched on, the sums go into fixed-bin
+// histograms in the DSelector output file, so the PROOF merge adds up the workers:
+//	stageTime: seconds per stage, stageCalls: times each stage ran, stageCounters: events and combos seen/cut/passed/written (seen = cut + passed;
+//	written also counts the combos cut by the analysis actions, so written >= passed),
+//	ancestryDepth: deepest thrown decay chain per event
+class StageTimers
+{
+	public:
+
+		enum Stage {kStageRead = 0, kStageThrown, kStageAncestry, kStagePhotonCache, kStageComboRecords, kStageActions, kStageUniqueness,
+			kStageHistograms, kStageComposition, kNumStages};
+		enum Counter {kCountEvents = 0, kCountCombosSeen, kCountCombosCut, kCountCombosPassed, kCountCombosWritten, kNumCounters};
+
+		// switches the instrumentation on and creates the histograms in the current directory (the DSelector output file)
+		void Initialize(Int_t locMaxAncestryDepth);
+		bool Get_EnabledFlag(void) const{return dEnabledFlag;}
+
+		void Start(Stage locStage)
+		{
+			if(dEnabledFlag)
+				dStartTimes[locStage] = chrono::steady_clock::now();
+		}
+		void Stop(Stage locStage)
+		{
+			if(!dEnabledFlag)
+				return;
+			dStageNanoseconds[locStage] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - dStartTimes[locStage]).count();
+			++dStageCalls[locStage];
+		}
+		void Count(Counter locCounter, Long64_t locNumber = 1)
+		{
+			if(dEnabledFlag)
+				dCounts[locCounter] += locNumber;
+		}
+		void Fill_AncestryDepth(Int_t locDepth)
+		{
+			if(dEnabledFlag)
+				dHist_ancestryDepth->Fill(locDepth);
+		}
+
+		// fills the histograms, and prints the per-stage times of this worker if locPrintFlag
+		void Finalize(bool locPrintFlag);
+
+		static const char* Get_StageName(Int_t locStage)
+		{
+			static const char* locNames[kNumStages] = {"DSelector::Process read", "thrown loop", "ancestry walk", "measured photon cache",
+				"combo records & cuts", "analysis actions", "uniqueness tracking", "histogram fills", "composition write"};
+			return locNames[locStage];
+		}
+
+	private:
+
+		bool dEnabledFlag = false;
+		chrono::steady_clock::time_point dStartTimes[kNumStages];
+		Long64_t dStageNanoseconds[kNumStages] = {};
+		Long64_t dStageCalls[kNumStages] = {};
+		Long64_t dCounts[kNumCounters] = {};
+
+		TH1D* dHist_stageTime = NULL;
+		TH1D* dHist_stageCalls = NULL;
+		TH1D* dHist_stageCounters = NULL;
+		TH1I* dHist_ancestryDepth = NULL;
+};
+
+// stops the stage when leaving the scope
+class ScopedStageTimer
+{
+	public:
+		ScopedStageTimer(StageTimers& locStageTimers, StageTimers::Stage locStage) : dStageTimers(locStageTimers), dStage(locStage)
+		{
+			dStageTimers.Start(dStage);
+		}
+		~ScopedStageTimer(void){dStageTimers.Stop(dStage);}
+
+	private:
+		StageTimers& dStageTimers;
+		StageTimers::Stage dStage;
+};
+
+inline void StageTimers::Initialize(Int_t locMaxAncestryDepth)
+{
+	dEnabledFlag = true;
+	dHist_stageTime = new TH1D("stageTime", ";;Wall time (s), sum over workers", kNumStages, 0, kNumStages);
+	dHist_stageCalls = new TH1D("stageCalls", ";;Calls, sum over workers", kNumStages, 0, kNumStages);
+	for(Int_t loc_i = 0; loc_i < kNumStages; ++loc_i)
+	{
+		dHist_stageTime->GetXaxis()->SetBinLabel(loc_i + 1, Get_StageName(loc_i));
+		dHist_stageCalls->GetXaxis()->SetBinLabel(loc_i + 1, Get_StageName(loc_i));
+	}
+	const char* locCounterNames[kNumCounters] = {"events", "combos seen", "combos cut", "combos passed", "combos written"};
+	dHist_stageCounters = new TH1D("stageCounters", ";;Sum over workers", kNumCounters, 0, kNumCounters);
+	for(Int_t loc_i = 0; loc_i < kNumCounters; ++loc_i)
+		dHist_stageCounters->GetXaxis()->SetBinLabel(loc_i + 1, locCounterNames[loc_i]);
+	dHist_ancestryDepth = new TH1I("ancestryDepth", ";Deepest thrown decay chain;Events", locMaxAncestryDepth + 1, -0.5, locMaxAncestryDepth + 0.5);
+}
+
+inline void StageTimers::Finalize(bool locPrintFlag)
+{
+	if(!dEnabledFlag)
+		return;
+	for(Int_t loc_i = 0; loc_i < kNumStages; ++loc_i)
+	{
+		dHist_stageTime->SetBinContent(loc_i + 1, dStageNanoseconds[loc_i]*1.0E-9);
+		dHist_stageCalls->SetBinContent(loc_i + 1, dStageCalls[loc_i]);
+	}
+	for(Int_t loc_i = 0; loc_i < kNumCounters; ++loc_i)
+		dHist_stageCounters->SetBinContent(loc_i + 1, dCounts[loc_i]);
+
+	if(!locPrintFlag)
+		return;
+	cout << "StageTimers: " << dCounts[kCountEvents] << " events, " << dCounts[kCountCombosSeen] << " combos seen, " << dCounts[kCountCombosCut]
+		<< " cut, " << dCounts[kCountCombosPassed] << " passed, " << dCounts[kCountCombosWritten] << " written" << endl;
+	for(Int_t loc_i = 0; loc_i < kNumStages; ++loc_i)
+	{
+		double locMicroseconds = (dCounts[kCountEvents] > 0) ? dStageNanoseconds[loc_i]*1.0E-3/dCounts[kCountEvents] : 0.0;
+		cout << "StageTimers: " << Get_StageName(loc_i) << ": " << dStageNanoseconds[loc_i]*1.0E-9 << " s, " << locMicroseconds << " us/event" << endl;
+	}
+}
+
+#endif // stageTimers_h
@@ -0,0 +1,239 @@
+#ifndef thrownAncestry_h
+#define thrownAncestry_h
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <functional>
+
+#include "Rtypes.h"
+#include "TString.h"
+
+using namespace std;
+
+// Per-event index of the thrown decay chains. Filled once per event from the thrown arrays, after which
+// the ancestry of any thrown index is an O(1) lookup instead of a walk up the parent indices.
+//
+// Every ancestor chain "(parentPID)(grandparentPID)..." is interned into a trie whose nodes are integer
+// chain codes, and every four-photon composition "chain1_chain2_chain3_chain4" is interned into a second
+// dictionary giving a composition code. Both dictionaries live for the whole job (not just the event),
+// so codes are stable within one worker and strings are only materialized when writing output.
+class ThrownAncestry
+{
+	public:
+
+		static const Int_t kEmptyChain = 0; // thrown particle without a parent: ""
+		static const Int_t kUnmatchedChain = 1; // reconstructed particle not matched to a thrown one: "(0)"
+		static const Int_t kMaxDepth = 32; // protect against malformed (cyclic) parent indices
+
+		ThrownAncestry(void)
+		{
+			// reserve the two special chain codes. A thrown parent with PID 0 (Unknown) and no further ancestors would
+			// print as "(0)" too, so it is interned to the unmatched node: one code per chain string
+			dChainNodes.push_back(pair<Int_t, Int_t>(-1, -1));
+			dChainNodes.push_back(pair<Int_t, Int_t>(0, Int_t(kEmptyChain)));
+			dChainLookup.emplace(Get_ChainKey(0, kEmptyChain), Int_t(kUnmatchedChain));
+		}
+
+		// call once per event, then Add_Thrown() for every thrown index in order, then Build()
+		void Reset(void)
+		{
+			dPIDs.clear();
+			dParentIndices.clear();
+			dChainCodes.clear();
+			dDepths.clear();
+		}
+		void Add_Thrown(Int_t locPID, Int_t locParentIndex)
+		{
+			dPIDs.push_back(locPID);
+			dParentIndices.push_back(locParentIndex);
+		}
+		void Build(void);
+
+		void Set_Topology(const TString& locTopology);
+		Int_t Get_TopologyCode(void) const{return dTopologyCode;}
+		const TString& Get_Topology(void) const{return dTopologyStrings[dTopologyCode];}
+
+		// thrown index of -1 (unmatched) returns kUnmatchedChain
+		Int_t Get_ChainCode(Int_t locThrownIndex) const;
+		Int_t Get_Depth(Int_t locThrownIndex) const;
+		size_t Get_NumThrown(void) const{return dPIDs.size();}
+
+		Int_t Get_CompositionCode(Int_t locThrownIndex1, Int_t locThrownIndex2, Int_t locThrownIndex3, Int_t locThrownIndex4);
+
+		// dictionaries
+		TString Get_ChainString(Int_t locChainCode) const;
+		TString Get_CompositionString(Int_t locCompositionCode) const;
+		// photons within the pi0 (1,2) and within the eta (3,4) are interchangeable: "(7)__(17)", "(17)_(7)__(17)_(7)", ...
+		TString Get_UniqueCompositionString(Int_t locCompositionCode) const;
+		const TString& Get_TopologyString(Int_t locTopologyCode) const{return dTopologyStrings[locTopologyCode];}
+		size_t Get_NumCompositions(void) const{return dCompositionChains.size();}
+		size_t Get_NumTopologies(void) const{return dTopologyStrings.size();}
+
+	private:
+
+		// (chains 1 & 2, chains 3 & 4), 32 bits per chain code
+		typedef pair<ULong64_t, ULong64_t> CompositionKey;
+		struct CompositionKeyHash
+		{
+			size_t operator()(const CompositionKey& locKey) const{return hash<ULong64_t>()(locKey.first ^ (locKey.second*0x9E3779B97F4A7C15ULL));}
+		};
+
+		static ULong64_t Get_ChainKey(Int_t locPID, Int_t locTailCode){return (ULong64_t(UInt_t(locPID)) << 32) | UInt_t(locTailCode);}
+		Int_t Get_CompositionChain(Int_t locCompositionCode, int locPosition) const
+		{
+			const CompositionKey& locKey = dCompositionChains[locCompositionCode];
+			ULong64_t locWord = (locPosition < 2) ? locKey.first : locKey.second;
+			return Int_t((locPosition % 2 == 0) ? (locWord >> 32) : (locWord & 0xFFFFFFFF));
+		}
+
+		Int_t Intern_Chain(Int_t locPID, Int_t locTailCode);
+		Int_t Build_Chain(Int_t locThrownIndex, Int_t locDepth);
+
+		// per event, indexed by thrown index
+		vector<Int_t> dPIDs;
+		vector<Int_t> dParentIndices;
+		vector<Int_t> dChainCodes; // -1 until built
+		vector<Int_t> dDepths;
+
+		// chain trie: node = (PID of first ancestor, code of the rest of the chain)
+		vector<pair<Int_t, Int_t> > dChainNodes;
+		unordered_map<ULong64_t, Int_t> dChainLookup;
+
+		// compositions: the four chain codes of the photons
+		vector<CompositionKey> dCompositionChains;
+		unordered_map<CompositionKey, Int_t, CompositionKeyHash> dCompositionLookup;
+
+		// topologies: consecutive events usually share a topology, so compare against the last one before the lookup
+		vector<TString> dTopologyStrings;
+		unordered_map<string, Int_t> dTopologyLookup;
+		Int_t dTopologyCode = -1;
+};
+
+inline void ThrownAncestry::Build(void)
+{
+	dChainCodes.assign(dPIDs.size(), -1);
+	dDepths.assign(dPIDs.size(), 0);
+	for(size_t loc_i = 0; loc_i < dPIDs.size(); ++loc_i)
+		Build_Chain(loc_i, 0);
+}
+
+inline Int_t ThrownAncestry::Build_Chain(Int_t locThrownIndex, Int_t locDepth)
+{
+	if(dChainCodes[locThrownIndex] != -1)
+		return dChainCodes[locThrownIndex];
+
+	Int_t locParentIndex = dParentIndices[locThrownIndex];
+	if((locParentIndex < 0) || (locParentIndex >= Int_t(dPIDs.size())) || (locDepth >= kMaxDepth))
+	{
+		dChainCodes[locThrownIndex] = kEmptyChain;
+		return kEmptyChain;
+	}
+
+	// the chain of a particle is its parent's PID followed by the chain of the parent
+	Int_t locTailCode = Build_Chain(locParentIndex, locDepth + 1);
+	dChainCodes[locThrownIndex] = Intern_Chain(dPIDs[locParentIndex], locTailCode);
+	dDepths[locThrownIndex] = dDepths[locParentIndex] + 1;
+	return dChainCodes[locThrownIndex];
+}
+
+inline Int_t ThrownAncestry::Intern_Chain(Int_t locPID, Int_t locTailCode)
+{
+	ULong64_t locKey = Get_ChainKey(locPID, locTailCode);
+	auto locIterator = dChainLookup.find(locKey);
+	if(locIterator != dChainLookup.end())
+		return locIterator->second;
+
+	Int_t locCode = dChainNodes.size();
+	dChainNodes.push_back(make_pair(locPID, locTailCode));
+	dChainLookup.emplace(locKey, locCode);
+	return locCode;
+}
+
+inline Int_t ThrownAncestry::Get_ChainCode(Int_t locThrownIndex) const
+{
+	if((locThrownIndex < 0) || (locThrownIndex >= Int_t(dChainCodes.size())))
+		return kUnmatchedChain;
+	return dChainCodes[locThrownIndex];
+}
+
+inline Int_t ThrownAncestry::Get_Depth(Int_t locThrownIndex) const
+{
+	if((locThrownIndex < 0) || (locThrownIndex >= Int_t(dDepths.size())))
+		return 0;
+	return dDepths[locThrownIndex];
+}
+
+inline Int_t ThrownAncestry::Get_CompositionCode(Int_t locThrownIndex1, Int_t locThrownIndex2, Int_t locThrownIndex3, Int_t locThrownIndex4)
+{
+	CompositionKey locKey((ULong64_t(UInt_t(Get_ChainCode(locThrownIndex1))) << 32) | UInt_t(Get_ChainCode(locThrownIndex2)),
+		(ULong64_t(UInt_t(Get_ChainCode(locThrownIndex3))) << 32) | UInt_t(Get_ChainCode(locThrownIndex4)));
+	auto locIterator = dCompositionLookup.find(locKey);
+	if(locIterator != dCompositionLookup.end())
+		return locIterator->second;
+
+	Int_t locCode = dCompositionChains.size();
+	dCompositionChains.push_back(locKey);
+	dCompositionLookup.emplace(locKey, locCode);
+	return locCode;
+}
+
+inline void ThrownAncestry::Set_Topology(const TString& locTopology)
+{
+	if((dTopologyCode >= 0) && (dTopologyStrings[dTopologyCode] == locTopology))
+		return;
+
+	string locKey = locTopology.Data();
+	auto locIterator = dTopologyLookup.find(locKey);
+	if(locIterator != dTopologyLookup.end())
+	{
+		dTopologyCode = locIterator->second;
+		return;
+	}
+
+	dTopologyCode = dTopologyStrings.size();
+	dTopologyStrings.push_back(locTopology);
+	dTopologyLookup.emplace(locKey, dTopologyCode);
+}
+
+inline TString ThrownAncestry::Get_ChainString(Int_t locChainCode) const
+{
+	// the unmatched node is stored as (0, kEmptyChain): it prints "(0)", also as the last ancestor of a longer chain
+	TString locChain = "";
+	while(locChainCode != kEmptyChain)
+	{
+		locChain += "(" + to_string(dChainNodes[locChainCode].first) + ")";
+		locChainCode = dChainNodes[locChainCode].second;
+	}
+	return locChain;
+}
+
+inline TString ThrownAncestry::Get_CompositionString(Int_t locCompositionCode) const
+{
+	return Get_ChainString(Get_CompositionChain(locCompositionCode, 0)) + "_" + Get_ChainString(Get_CompositionChain(locCompositionCode, 1))
+		+ "_" + Get_ChainString(Get_CompositionChain(locCompositionCode, 2)) + "_" + Get_ChainString(Get_CompositionChain(locCompositionCode, 3));
+}
+
+inline TString ThrownAncestry::Get_UniqueCompositionString(Int_t locCompositionCode) const
+{
+	TString locChains[4];
+	for(int loc_i = 0; loc_i < 4; ++loc_i)
+		locChains[loc_i] = Get_ChainString(Get_CompositionChain(locCompositionCode, loc_i));
+
+	TString locUniqueComposition = "";
+	for(int loc_i = 0; loc_i < 4; loc_i += 2)
+	{
+		if(loc_i != 0)
+			locUniqueComposition += "__";
+		if(locChains[loc_i] == locChains[loc_i + 1])
+			locUniqueComposition += locChains[loc_i];
+		else if(locChains[loc_i] < locChains[loc_i + 1])
+			locUniqueComposition += locChains[loc_i] + "_" + locChains[loc_i + 1];
+		else
+			locUniqueComposition += locChains[loc_i + 1] + "_" + locChains[loc_i];
+	}
+	return locUniqueComposition;
+}
+
+#endif // thrownAncestry_h
@@ -0,0 +1,141 @@
+#ifndef uniquenessTracker_h
+#define uniquenessTracker_h
+
+#include <array>
+#include <vector>
+#include <limits>
+
+#include "Rtypes.h"
+
+using namespace std;
+
+template <int... locGroupSizes> struct UniquenessKeySize;
+template <> struct UniquenessKeySize<>{static const int value = 0;};
+template <int locGroupSize, int... locOtherGroupSizes> struct UniquenessKeySize<locGroupSize, locOtherGroupSizes...>
+{
+	static const int value = locGroupSize + UniquenessKeySize<locOtherGroupSizes...>::value;
+};
+
+// Allocation-free replacement for the set<map<Particle_t, set<Int_t> > > uniqueness tracking of the DSelector template.
+//
+// The template arguments are the number of IDs in each particle group, e.g. UniquenessTracker<1, 1, 4> for
+// {beam}, {proton}, {photon1..4}. IDs are passed in group order; within a group they are sorted (and duplicates
+// dropped, as set<Int_t> would), so the key is the same for any ordering of the group. Keys go into an
+// open-addressing hash table that is cleared in O(1) by bumping a generation counter: the memory is kept
+// between events and only grows when an event has more unique keys than ever before.
+template <int... locGroupSizes>
+class UniquenessTracker
+{
+	public:
+
+		static const int kKeySize = UniquenessKeySize<locGroupSizes...>::value;
+		typedef array<Int_t, kKeySize> Key;
+
+		UniquenessTracker(void){Resize(64);}
+
+		// call once per event
+		void Reset(void)
+		{
+			dNumEntries = 0;
+			if(++dGeneration != 0)
+				return;
+			// generation counter wrapped: really clear
+			dGenerations.assign(dGenerations.size(), 0);
+			dGeneration = 1;
+		}
+
+		// true if this combination of IDs has not been inserted since the last Reset(), i.e. "not used so far"
+		bool Insert(Key locKey)
+		{
+			Canonicalize(locKey);
+			if(2*(dNumEntries + 1) > dKeys.size())
+				Resize(2*dKeys.size());
+			size_t locSlot = Find_Slot(locKey);
+			if(dGenerations[locSlot] == dGeneration)
+				return false;
+			dKeys[locSlot] = locKey;
+			dGenerations[locSlot] = dGeneration;
+			++dNumEntries;
+			return true;
+		}
+
+		size_t Get_NumEntries(void) const{return dNumEntries;}
+
+	private:
+
+		static void Canonicalize(Key& locKey)
+		{
+			static const int locSizes[] = {locGroupSizes...};
+			int locBegin = 0;
+			for(int locSize : locSizes)
+			{
+				// insertion sort: groups hold a handful of IDs
+				for(int loc_i = locBegin + 1; loc_i < locBegin + locSize; ++loc_i)
+				{
+					Int_t locID = locKey[loc_i];
+					int loc_j = loc_i;
+					for(; (loc_j > locBegin) && (locKey[loc_j - 1] > locID); --loc_j)
+						locKey[loc_j] = locKey[loc_j - 1];
+					locKey[loc_j] = locID;
+				}
+				// set semantics: drop duplicates, pad the end of the group
+				int locNumUnique = (locSize > 0) ? 1 : 0;
+				for(int loc_i = locBegin + 1; loc_i < locBegin + locSize; ++loc_i)
+				{
+					if(locKey[loc_i] != locKey[locBegin + locNumUnique - 1])
+						locKey[locBegin + locNumUnique++] = locKey[loc_i];
+				}
+				for(int loc_i = locBegin + locNumUnique; loc_i < locBegin + locSize; ++loc_i)
+					locKey[loc_i] = numeric_limits<Int_t>::min();
+				locBegin += locSize;
+			}
+		}
+
+		static size_t Hash(const Key& locKey)
+		{
+			ULong64_t locHash = 0xcbf29ce484222325ULL;
+			for(Int_t locID : locKey)
+			{
+				locHash ^= UInt_t(locID);
+				locHash *= 0x9E3779B97F4A7C15ULL;
+				locHash ^= locHash >> 29;
+			}
+			return locHash;
+		}
+
+		// slot holding locKey in the current generation, else the empty slot where it would go
+		size_t Find_Slot(const Key& locKey) const
+		{
+			size_t locMask = dKeys.size() - 1;
+			size_t locSlot = Hash(locKey) & locMask;
+			while((dGenerations[locSlot] == dGeneration) && (dKeys[locSlot] != locKey))
+				locSlot = (locSlot + 1) & locMask;
+			return locSlot;
+		}
+
+		void Resize(size_t locNumSlots)
+		{
+			vector<Key> locOldKeys;
+			vector<UInt_t> locOldGenerations;
+			locOldKeys.swap(dKeys);
+			locOldGenerations.swap(dGenerations);
+
+			dKeys.resize(locNumSlots);
+			dGenerations.assign(locNumSlots, 0);
+			for(size_t loc_i = 0; loc_i < locOldKeys.size(); ++loc_i)
+			{
+				if(locOldGenerations[loc_i] != dGeneration)
+					continue;
+				size_t locSlot = Find_Slot(locOldKeys[loc_i]);
+				dKeys[locSlot] = locOldKeys[loc_i];
+				dGenerations[locSlot] = dGeneration;
+			}
+		}
+
+		vector<Key> dKeys; //size is a power of 2
+		vector<UInt_t> dGenerations; //slot is occupied if equal to dGeneration
+		UInt_t dGeneration = 1;
+		size_t dNumEntries = 0;
+};
+
+#endif // uniquenessTracker_h